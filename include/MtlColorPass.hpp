@@ -0,0 +1,31 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLCOLORPASS_HPP
+#define MTLCOLORPASS_HPP
+
+#include <cstddef>
+
+/** Steps of the colour pass, applied in this order */
+enum MtlColorPassFlags {
+  CP_NORMALIZE_255 = 1 << 0, // Divide triples with a component > 1 by 255
+  CP_CLAMP = 1 << 1, // Clamp every component to [0 - 1]
+  CP_SRGB_TO_LINEAR = 1 << 2, // Convert from sRGB to linear
+  CP_ALL = CP_NORMALIZE_255 | CP_CLAMP | CP_SRGB_TO_LINEAR,
+};
+
+/**
+ Maximum relative difference between mtlColorPass() and
+ mtlColorPassScalar(): |result - reference| <= tolerance * max(1, |reference|).
+ This is an absolute bound for colours in [0 - 1], which is what the pass
+ produces with CP_CLAMP, and a relative one above that.
+ */
+#define MTL_COLOR_PASS_TOLERANCE 1e-5f
+
+void mtlColorPass(float* red, float* green, float* blue, size_t count,
+    unsigned int flags);
+void mtlColorPassScalar(float* red, float* green, float* blue, size_t count,
+    unsigned int flags);
+
+#endif /* MTLCOLORPASS_HPP */
@@ -22,10 +22,10 @@ public:
       bool isLast = false);
 
   std::string name; // newmtl (string)
-  MtlColor ambientColor, diffuseColor, specularColor; // Ka, Kd, Ks (3 * [0 - 1])
+  MtlColor ambientColor, diffuseColor, specularColor; // Ka, Kd, Ks (3 * [0 - 1] or [0 - 255])
   MtlColor transformFilter; // Tf (3 * [0 - 1])
   int illumination; // illum (0 - 10) (predefined meaning, enum)
-  float dissolve; // d (0.0 - 1.0)
+  float dissolve; // d (0.0 - 1.0, default 1.0)
   bool dissolveHalo; // -halo (true if 'd' has '-halo' option, else false)
   int specularExponent; // Ns (0 - 1000)
   int sharpness; // sharpness (0 - 1000)
@@ -5,23 +5,62 @@
 #ifndef MTLOBJECT_HPP
 #define MTLOBJECT_HPP
 
+#include <cstdint>
+#include <istream>
 #include <string>
 #include <vector>
 
+#include "MtlColorPass.hpp"
 #include "MtlMap.hpp"
 #include "MtlMaterial.hpp"
+#include "MtlParseStats.hpp"
+#include "MtlSortKey.hpp"
 
 class MtlObject {
 
 public:
-  MtlObject(const std::string& fileName);
+  MtlObject(const std::string& fileName, MtlParseStats* stats = nullptr);
+  MtlObject(std::istream& data, const std::string& name = std::string(),
+      MtlParseStats* stats = nullptr);
   ~MtlObject(void);
+
+  /* Owns the materials, copying would delete them twice */
+  MtlObject(const MtlObject&) = delete;
+  MtlObject& operator=(const MtlObject&) = delete;
   void printMaterials(void);
+  void updateSortKeys(void);
+  void normalizeColors(unsigned int flags = CP_ALL);
+
+  /** Sort keys of all materials (see MtlSortKey.hpp), sorted ascending */
+  const std::vector<uint64_t>& sortKeys(void) const { return mSortKeys; }
+
+  std::vector<uint32_t> queryMaterials(uint32_t mask, uint32_t value) const;
+
+  /**
+   Returns the indices of all materials whose features word satisfies
+   'pred', ordered by sort key
+   */
+  template<typename Pred> std::vector<uint32_t> queryMaterials(Pred pred) const
+  {
+    return mtlQuerySortKeys(mSortKeys, pred);
+  }
+
+  /**
+   Diagnostics while loading (created materials, skipped or failed lines,
+   files that cannot be opened) are only written to stdout/stderr when
+   enabled. Off by default, applies to all threads.
+   */
+  static void setVerbose(bool verbose);
+  static bool verbose(void);
 
   std::string mFileName;
   std::vector<MtlMaterial *> materials;
 
 private:
+  void parse(std::istream& data, MtlParseStats* stats);
+
+  std::vector<uint64_t> mSortKeys;
+
   void skipOptionalChars(const std::string& data, std::string::size_type& pos);
   void skipToNextLine(const std::string& data, std::string::size_type& pos);
 };
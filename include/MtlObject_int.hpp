@@ -25,6 +25,7 @@ typedef enum mtlKeyType {
   KT_BUMP,
   KT_MAPBUMP,
   KT_REFL,
+  KT_MAPAAT,
 } mtlKeyType;
 
 typedef enum mtlValType {
@@ -44,6 +45,7 @@ typedef mtlValType mtlOptType;
 typedef struct mtlOpt {
     const char* optName;
     const mtlOptType optType;
+    const float optDefault; /* Value of omitted optional float arguments */
 } mtlOpt;
 
 typedef struct mtlVal {
@@ -79,6 +81,27 @@ static const mtlVal intVal = { nullptr, VT_INT };
 /** Possible values - single float */
 static const mtlVal floatVal = { nullptr, VT_FLOAT };
 
+/** Possible values - string (file name or on/off) */
+static const mtlVal stringVal = { nullptr, VT_STRING };
+
+/** Texture map options */
+static const mtlOpt mapOpts[] = {
+    { "-blendu", VT_STRING },
+    { "-blendv", VT_STRING },
+    { "-boost", VT_FLOAT },
+    { "-cc", VT_STRING },
+    { "-clamp", VT_STRING },
+    { "-imfchan", VT_STRING },
+    { "-mm", VT_2FLOATS, 1.0f }, /* base gain, gain defaults to 1 */
+    { "-o", VT_3FLOATS, 0.0f }, /* u v w, v and w default to 0 */
+    { "-s", VT_3FLOATS, 1.0f }, /* u v w, v and w default to 1 */
+    { "-t", VT_3FLOATS, 0.0f }, /* u v w, v and w default to 0 */
+    { "-texres", VT_STRING },
+    { "-bm", VT_FLOAT },
+};
+
+#define NR_MAP_OPTS (sizeof(mapOpts) / sizeof(mapOpts[0]))
+
 /** A structure describing the possible MTL file material
     parameters and its options */
 static const mtlKey keys[] = {
@@ -101,6 +124,20 @@ static const mtlKey keys[] = {
     { "d", KT_D, 1, &dOpts, 1, &floatVal },
 
     { "Ns", KT_NS, 0, nullptr, 1, &intVal },
+
+    { "map_Ka", KT_MAPKA, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "map_Kd", KT_MAPKD, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "map_Ks", KT_MAPKS, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "map_Ns", KT_MAPNS, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "decal", KT_DECAL, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "disp", KT_DISP, NR_MAP_OPTS, mapOpts, 1, &stringVal },
+
+    { "map_aat", KT_MAPAAT, 0, nullptr, 1, &stringVal },
 };
 
 #endif /* _MTLOBJECT_INT_HPP_ */
@@ -0,0 +1,42 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLPARSESTATS_HPP
+#define MTLPARSESTATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/** Upper bound of the number of keys the parser knows */
+#define MTL_STATS_MAX_KEYS 32
+
+/**
+ Counters and per-phase timings filled in by MtlObject when given a
+ pointer to one. Parsing several files into the same struct sums them up.
+ Building with -DMTL_NO_STATS compiles all instrumentation out of the
+ parser and leaves the struct zeroed.
+ */
+struct MtlParseStats {
+  MtlParseStats(void);
+  void printJson(std::ostream& out = std::cout) const;
+  static const char* keyName(size_t index);
+
+  uint64_t bytesRead;
+  uint64_t linesRead;
+  uint64_t materialLines; // newmtl
+  uint64_t keyLines[MTL_STATS_MAX_KEYS]; // per key, name from keyName()
+  uint64_t unmatchedLines; // no known key (also comments and blank lines)
+  uint64_t skippedLines; // before the first newmtl
+  uint64_t valueFailures; // known key with a value that failed to parse
+  uint64_t allocations; // materials and option values
+
+  /* Time spent per phase, in nanoseconds */
+  uint64_t ioTime; // reading lines
+  uint64_t keywordTime; // matching keys and value names
+  uint64_t valueTime; // parsing values
+  uint64_t optionTime; // parsing options
+};
+
+#endif /* MTLPARSESTATS_HPP */
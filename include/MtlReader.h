@@ -0,0 +1,86 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLREADER_H
+#define MTLREADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ Flat C interface to libmtlreader.so.
+
+ A handle owns a parsed material library laid out as contiguous POD
+ arrays with one element per material, in file order. All pointers
+ returned for a handle stay valid and unchanged until mtlClose(), so they
+ can be wrapped (numpy, Rust slices, ...) without copying.
+
+ Names and texture file names live in one string table of NUL terminated
+ strings, referenced by byte offsets. Offset 0 is always the empty string,
+ used for maps that are not set.
+ */
+typedef struct mtlHandle mtlHandle;
+
+/** Colour arrays, 3 floats (red, green, blue) per material */
+typedef enum mtlColorSlot {
+  CS_KA, // ambientColor
+  CS_KD, // diffuseColor
+  CS_KS, // specularColor
+  CS_TF, // transformFilter
+  CS_COUNT,
+} mtlColorSlot;
+
+/** Texture map file name arrays, 1 string table offset per material */
+typedef enum mtlMapSlot {
+  MS_KA, // mapAmbientColor
+  MS_KD, // mapDiffuseColor
+  MS_KS, // mapSpecularColor
+  MS_NS, // mapSpecularExponent
+  MS_DECAL, // decal
+  MS_DISP, // disposition
+  MS_COUNT,
+} mtlMapSlot;
+
+/*
+ Return NULL only if the file cannot be opened or loading fails
+ internally (e.g. out of memory). Lines that fail to parse are skipped, so
+ input that is not MTL at all gives a valid handle with 0 materials.
+ */
+mtlHandle* mtlOpenFile(const char* fileName);
+mtlHandle* mtlOpenBuffer(const char* data, size_t size);
+void mtlClose(mtlHandle* handle);
+
+/*
+ Loading writes nothing to stdout/stderr unless 'verbose' is non-zero, in
+ which case parse diagnostics are printed. Affects all handles and threads.
+ */
+void mtlSetVerbose(int verbose);
+
+size_t mtlMaterialCount(const mtlHandle* handle);
+
+const float* mtlColors(const mtlHandle* handle, mtlColorSlot slot);
+const int32_t* mtlIllumination(const mtlHandle* handle);
+const float* mtlDissolve(const mtlHandle* handle);
+const uint8_t* mtlDissolveHalo(const mtlHandle* handle);
+const int32_t* mtlSpecularExponent(const mtlHandle* handle);
+const int32_t* mtlSharpness(const mtlHandle* handle);
+const float* mtlOpticalDensity(const mtlHandle* handle);
+const uint8_t* mtlMapAntiAliasingTextures(const mtlHandle* handle);
+
+/* Sort keys (see MtlSortKey.hpp), sorted ascending, not in file order */
+const uint64_t* mtlSortKeys(const mtlHandle* handle);
+
+const char* mtlStringTable(const mtlHandle* handle, size_t* size);
+const uint32_t* mtlNameOffsets(const mtlHandle* handle);
+const uint32_t* mtlMapOffsets(const mtlHandle* handle, mtlMapSlot slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTLREADER_H */
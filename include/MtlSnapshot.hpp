@@ -0,0 +1,79 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLSNAPSHOT_HPP
+#define MTLSNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MtlMaterial.hpp"
+#include "MtlObject.hpp"
+#include "MtlSortKey.hpp"
+
+/**
+ An immutable copy of a parsed material library. Snapshots are only ever
+ handed out as std::shared_ptr<const MtlSnapshot>, so any number of threads
+ can read one without synchronization and it is freed when the last reader
+ drops it.
+ */
+class MtlSnapshot {
+public:
+  MtlSnapshot(void);
+  MtlSnapshot(const MtlObject& object);
+
+  std::vector<uint32_t> queryMaterials(uint32_t mask, uint32_t value) const;
+
+  /**
+   Returns the indices of all materials whose features word satisfies
+   'pred', ordered by sort key
+   */
+  template<typename Pred> std::vector<uint32_t> queryMaterials(Pred pred) const
+  {
+    return mtlQuerySortKeys(sortKeys, pred);
+  }
+
+  const std::string fileName;
+  const std::vector<MtlMaterial> materials;
+  const std::vector<uint64_t> sortKeys;
+};
+
+/**
+ Holds the current snapshot of a material library and replaces it
+ atomically. Readers call snapshot() and keep the returned pointer for as
+ long as they need consistent data; a reload never modifies a published
+ snapshot, it parses into a new one and swaps the pointer.
+
+ snapshot() is lock-free: it only uses atomic counters on two snapshot
+ slots (std::atomic_load() on a shared_ptr is not, libstdc++ implements it
+ with a mutex pool). A reader retries only if a publish happened while it
+ was copying. Publishers are serialized by a mutex and wait for readers
+ that are still copying from the slot they are about to change.
+ */
+class MtlLibrary {
+public:
+  MtlLibrary(void);
+  MtlLibrary(const std::string& fileName);
+
+  MtlLibrary(const MtlLibrary&) = delete;
+  MtlLibrary& operator=(const MtlLibrary&) = delete;
+
+  std::shared_ptr<const MtlSnapshot> snapshot(void) const;
+  void publish(std::shared_ptr<const MtlSnapshot> snapshot);
+  bool reload(const std::string& fileName);
+
+private:
+  void waitForReaders(unsigned int slot) const;
+
+  std::shared_ptr<const MtlSnapshot> mSlots[2];
+  std::atomic<unsigned int> mCurrent; // index of the slot readers copy
+  mutable std::atomic<unsigned int> mReaders[2]; // readers copying a slot
+  std::mutex mPublishMutex;
+};
+
+#endif /* MTLSNAPSHOT_HPP */
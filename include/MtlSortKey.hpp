@@ -0,0 +1,80 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLSORTKEY_HPP
+#define MTLSORTKEY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "MtlMaterial.hpp"
+
+/**
+ Material sort keys pack everything a renderer needs to pick a shader
+ permutation into a single 64-bit integer:
+
+ bit  63     transparent ('d' < 1 or 'd -halo')
+ bits 56-59  illumination model (illum, 0 - 15)
+ bits 32-38  populated map slots (MF_MAP_* below)
+ bits 0-31   material index in the owning object
+
+ The upper 32 bits are the "features" word, so sorting the keys groups
+ opaque materials before transparent ones, then by illumination model and
+ then by map slots. The index in the low bits keeps the keys unique and
+ makes the sorted key array double as a sorted index list.
+ */
+enum MtlFeature : uint32_t {
+  MF_MAP_KA = 1u << 0, // map_Ka
+  MF_MAP_KD = 1u << 1, // map_Kd
+  MF_MAP_KS = 1u << 2, // map_Ks
+  MF_MAP_NS = 1u << 3, // map_Ns
+  MF_DECAL = 1u << 4, // decal
+  MF_DISP = 1u << 5, // disp
+  MF_MAP_AAT = 1u << 6, // map_aat
+  MF_ILLUM_MASK = 0xfu << 24, // illum, use mtlIllumFeature()
+  MF_TRANSPARENT = 1u << 31, // d < 1 or -halo
+};
+
+/** Returns the features word bits for the illumination model 'illum' */
+inline uint32_t
+mtlIllumFeature(int illum)
+{
+  return (static_cast<uint32_t>(illum) << 24) & MF_ILLUM_MASK;
+}
+
+/** Returns the features word (upper 32 bits) of a sort key */
+inline uint32_t
+mtlSortKeyFeatures(uint64_t key)
+{
+  return static_cast<uint32_t>(key >> 32);
+}
+
+/** Returns the material index (lower 32 bits) of a sort key */
+inline uint32_t
+mtlSortKeyIndex(uint64_t key)
+{
+  return static_cast<uint32_t>(key);
+}
+
+uint64_t mtlMaterialSortKey(const MtlMaterial& mat, uint32_t index);
+void mtlRadixSort(std::vector<uint64_t>& keys);
+std::vector<uint32_t> mtlQuerySortKeys(const std::vector<uint64_t>& sortedKeys,
+    uint32_t mask, uint32_t value);
+
+/**
+ Returns the material indices of all keys in 'sortedKeys' whose features
+ word satisfies 'pred', in key order
+ */
+template<typename Pred> std::vector<uint32_t>
+mtlQuerySortKeys(const std::vector<uint64_t>& sortedKeys, Pred pred)
+{
+  std::vector<uint32_t> indices;
+  for (const auto key : sortedKeys) {
+    if (pred(mtlSortKeyFeatures(key)))
+      indices.push_back(mtlSortKeyIndex(key));
+  }
+  return indices;
+}
+
+#endif /* MTLSORTKEY_HPP */
@@ -0,0 +1,59 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef OBJMTLRESOLVER_HPP
+#define OBJMTLRESOLVER_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "MtlMaterial.hpp"
+#include "MtlObject.hpp"
+
+/**
+ A run of consecutive faces ('f' lines) in an OBJ file that share the same
+ 'usemtl' material
+ */
+struct ObjMtlRange {
+  int materialIndex; // index into ObjMtlResolver::materials, -1 if none
+  size_t firstFace; // zero based index of the first face
+  size_t faceCount;
+};
+
+/**
+ Streams a Wavefront OBJ file and resolves its 'mtllib' and 'usemtl'
+ statements into a material-to-face-range table. Every referenced MTL file
+ is loaded once, every material gets a dense index and geometry lines are
+ only counted, never parsed.
+ */
+class ObjMtlResolver {
+public:
+  ObjMtlResolver(const std::string& fileName);
+  ~ObjMtlResolver(void);
+
+  /* Owns the libraries, copying would delete them twice */
+  ObjMtlResolver(const ObjMtlResolver&) = delete;
+  ObjMtlResolver& operator=(const ObjMtlResolver&) = delete;
+
+  void printRanges(void);
+
+  std::string mFileName;
+  std::vector<MtlObject *> libraries; // mtllib, in order of appearance
+  std::vector<const MtlMaterial *> materials; // dense material index table
+  std::vector<ObjMtlRange> ranges; // in face order
+
+private:
+  void loadLibrary(const std::string& fileName);
+  void useMaterial(const std::string& name);
+
+  std::string mBaseDir;
+  std::unordered_set<std::string> mLoadedLibraries;
+  std::unordered_map<std::string, int> mMaterialIndices;
+  size_t mFaceCount;
+};
+
+#endif /* OBJMTLRESOLVER_HPP */
@@ -0,0 +1,135 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "MtlColorPass.hpp"
+
+using namespace std;
+
+#define SRGB_THRESHOLD 0.04045f
+
+static float
+srgbToLinear(float c)
+{
+  return (c <= SRGB_THRESHOLD ? c / 12.92f :
+      pow((c + 0.055f) / 1.055f, 2.4f));
+}
+
+/**
+ Reference implementation of mtlColorPass(), one triple at a time using
+ std::pow. 'red', 'green' and 'blue' hold 'count' components each.
+ */
+void
+mtlColorPassScalar(float* red, float* green, float* blue, size_t count,
+    unsigned int flags)
+{
+  for (size_t i = 0; i < count; ++i) {
+    float* triple[3] = { &red[i], &green[i], &blue[i] };
+
+    if ((flags & CP_NORMALIZE_255) && (max(red[i], max(green[i], blue[i])) >
+        1.0f)) {
+      for (auto c : triple)
+        *c /= 255.0f;
+    }
+    if (flags & CP_CLAMP) {
+      for (auto c : triple)
+        *c = min(max(*c, 0.0f), 1.0f);
+    }
+    if (flags & CP_SRGB_TO_LINEAR) {
+      for (auto c : triple)
+        *c = srgbToLinear(*c);
+    }
+  }
+}
+
+#ifdef __SSE2__
+
+/**
+ sRGB to linear for 4 components. x^2.4 is computed as x^2 * (x^2)^(1/5),
+ the fifth root from an exponent bit trick estimate refined with Newton's
+ method, which is exact to float precision for the colour range.
+ */
+static inline __m128
+srgbToLinear4(__m128 c)
+{
+  const __m128 low = _mm_mul_ps(c, _mm_set1_ps(1.0f / 12.92f));
+  const __m128 x = _mm_mul_ps(_mm_add_ps(c, _mm_set1_ps(0.055f)),
+      _mm_set1_ps(1.0f / 1.055f));
+  const __m128 z = _mm_mul_ps(x, x);
+
+  /* bits(z^(1/5)) ~= bits(z) / 5 + 4 / 5 * bits(1.0) */
+  __m128 y = _mm_castsi128_ps(_mm_cvtps_epi32(_mm_add_ps(
+      _mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(z)), _mm_set1_ps(0.2f)),
+      _mm_set1_ps(0.8f * 1065353216.0f))));
+
+  /* y = (4 * y + z / y^4) / 5 */
+  for (int i = 0; i < 4; ++i) {
+    __m128 y2 = _mm_mul_ps(y, y);
+    y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(4.0f)),
+        _mm_div_ps(z, _mm_mul_ps(y2, y2))), _mm_set1_ps(0.2f));
+  }
+
+  const __m128 high = _mm_mul_ps(z, y);
+  const __m128 mask = _mm_cmpgt_ps(c, _mm_set1_ps(SRGB_THRESHOLD));
+
+  return _mm_or_ps(_mm_and_ps(mask, high), _mm_andnot_ps(mask, low));
+}
+
+#endif /* __SSE2__ */
+
+/**
+ Normalizes, clamps and/or converts the colour triples (red[i], green[i],
+ blue[i]) in place, 4 triples at a time where SSE2 is available. Results
+ match mtlColorPassScalar() within MTL_COLOR_PASS_TOLERANCE (relative).
+ */
+void
+mtlColorPass(float* red, float* green, float* blue, size_t count,
+    unsigned int flags)
+{
+  size_t i = 0;
+
+#ifdef __SSE2__
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 inv255 = _mm_set1_ps(1.0f / 255.0f);
+
+  for (; i + 4 <= count; i += 4) {
+    __m128 r = _mm_loadu_ps(&red[i]);
+    __m128 g = _mm_loadu_ps(&green[i]);
+    __m128 b = _mm_loadu_ps(&blue[i]);
+
+    if (flags & CP_NORMALIZE_255) {
+      __m128 mask = _mm_cmpgt_ps(_mm_max_ps(r, _mm_max_ps(g, b)), one);
+      __m128 scale = _mm_or_ps(_mm_and_ps(mask, inv255),
+          _mm_andnot_ps(mask, one));
+      r = _mm_mul_ps(r, scale);
+      g = _mm_mul_ps(g, scale);
+      b = _mm_mul_ps(b, scale);
+    }
+    if (flags & CP_CLAMP) {
+      r = _mm_min_ps(_mm_max_ps(r, zero), one);
+      g = _mm_min_ps(_mm_max_ps(g, zero), one);
+      b = _mm_min_ps(_mm_max_ps(b, zero), one);
+    }
+    if (flags & CP_SRGB_TO_LINEAR) {
+      r = srgbToLinear4(r);
+      g = srgbToLinear4(g);
+      b = srgbToLinear4(b);
+    }
+
+    _mm_storeu_ps(&red[i], r);
+    _mm_storeu_ps(&green[i], g);
+    _mm_storeu_ps(&blue[i], b);
+  }
+#endif /* __SSE2__ */
+
+  mtlColorPassScalar(&red[i], &green[i], &blue[i], count - i, flags);
+}
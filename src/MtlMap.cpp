@@ -6,11 +6,25 @@
 
 using namespace std;
 
-MtlMap::MtlMap(const string& mapName) : name(mapName)
-{}
+MtlMap::MtlMap(const string& mapName) : name(mapName), blendU(true),
+    blendV(true), clamp(false), imfChan(l)
+{
+  mm[0] = 0.0f;
+  mm[1] = 1.0f;
+  for (int i = 0; i < 3; ++i) {
+    offset[i] = 0.0f;
+    scale[i] = 1.0f;
+    turbulence[i] = 0.0f;
+  }
+  textureResolution[0] = 0;
+  textureResolution[1] = 0;
+}
 
 void
 MtlMap::printProperties(const string& prefix, bool isLast)
 {
-  cout << prefix << (isLast ? " └─" : " ├─") << "Map name: " << name << endl;
+  cout << prefix << (isLast ? " └─" : " ├─") << "Map name: " << name;
+  if (!fileName.empty())
+    cout << " (" << fileName << ")";
+  cout << endl;
 }
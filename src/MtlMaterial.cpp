@@ -9,7 +9,7 @@
 using namespace std;
 
 MtlMaterial::MtlMaterial(const std::string& matName) :
-    name(matName), illumination(0), dissolve(0.0f),
+    name(matName), illumination(0), dissolve(1.0f), dissolveHalo(false),
     specularExponent(0), sharpness(0.0f), opticalDensity(0.0f),
     mapAmbientColor("ambient"), mapDiffuseColor("diffuse"),
     mapSpecularColor("specular color"),
@@ -2,6 +2,9 @@
  * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
  */
 
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <list>
@@ -17,28 +20,98 @@
 #define MATERIAL_SENINTEL "newmtl"
 #define MATERIAL_SENINTEL_LEN 7
 
+/* Instrumentation, only active when a MtlParseStats pointer was given.
+   With MTL_NO_STATS every instrumented branch is dead code. */
+#ifndef MTL_NO_STATS
+#define STATS_ENABLED(stats) ((stats) != nullptr)
+#else
+#define STATS_ENABLED(stats) false
+#endif
+#define STATS_ADD(stats, field, n) \
+    do { if (STATS_ENABLED(stats)) (stats)->field += (n); } while (0)
+#define STATS_NOW(stats) (STATS_ENABLED(stats) ? \
+    chrono::steady_clock::now() : chrono::steady_clock::time_point())
+
 using namespace std;
 
-static void parseLine(vector<MtlMaterial *>& materials, const string& data);
+static void parseLine(vector<MtlMaterial *>& materials, const string& data,
+    MtlParseStats* stats);
+
+static atomic<bool> verboseOutput(false);
+
+void
+MtlObject::setVerbose(bool verbose)
+{
+  verboseOutput = verbose;
+}
+
+bool
+MtlObject::verbose(void)
+{
+  return verboseOutput;
+}
+
+/** Returns the nanoseconds passed since 'start' */
+static uint64_t
+elapsed(const chrono::steady_clock::time_point& start)
+{
+  return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now() - start).count());
+}
 
-MtlObject::MtlObject(const string& fileName) : mFileName(fileName)
+/**
+ Parses the MTL file 'fileName'. If 'stats' is given, parse counters and
+ timings are added to it.
+ */
+MtlObject::MtlObject(const string& fileName, MtlParseStats* stats) :
+    mFileName(fileName)
 {
   ifstream dataFile(fileName);
-  string line;
-  if (!dataFile.is_open()) {
+  if (!dataFile.is_open() && verbose()) {
     cerr << "Failed to open file '" << fileName << "'" << endl;
   }
 
-  while (getline(dataFile, line))
+  parse(dataFile, stats);
+
+  dataFile.close();
+}
+
+/**
+ Parses MTL data from an already open stream, 'name' is only used as
+ mFileName when printing
+ */
+MtlObject::MtlObject(istream& data, const string& name,
+    MtlParseStats* stats) : mFileName(name)
+{
+  parse(data, stats);
+}
+
+void
+MtlObject::parse(istream& data, MtlParseStats* stats)
+{
+  string line;
+
+  auto ioStart = STATS_NOW(stats);
+  while (getline(data, line))
   {
-    parseLine(materials, line);
+    STATS_ADD(stats, ioTime, elapsed(ioStart));
+    STATS_ADD(stats, linesRead, 1);
+    /* getline() sets eof when the last line has no newline */
+    STATS_ADD(stats, bytesRead, line.length() + (data.eof() ? 0 : 1));
+
+    parseLine(materials, line, stats);
+
+    ioStart = STATS_NOW(stats);
   }
+  STATS_ADD(stats, ioTime, elapsed(ioStart));
 
-  dataFile.close();
+  updateSortKeys();
 }
 
 MtlObject::~MtlObject(void)
 {
+  for (auto mat : materials)
+    delete mat;
   materials.clear();
 }
 
@@ -53,10 +126,76 @@ MtlObject::printMaterials(void)
   }
 }
 
+/**
+ Recomputes the sort keys of all materials, needed only if 'materials' has
+ been modified after parsing
+ */
+void
+MtlObject::updateSortKeys(void)
+{
+  mSortKeys.clear();
+  mSortKeys.reserve(materials.size());
+  for (uint32_t i = 0; i < materials.size(); ++i) {
+    if (materials[i])
+      mSortKeys.push_back(mtlMaterialSortKey(*materials[i], i));
+  }
+  mtlRadixSort(mSortKeys);
+}
+
+/**
+ Runs the colour pass (see MtlColorPass.hpp) over Ka, Kd, Ks and Tf of all
+ materials. The colours are gathered into one contiguous array per
+ component so the whole library goes through the kernel in a single call.
+ */
+void
+MtlObject::normalizeColors(unsigned int flags)
+{
+  vector<MtlColor *> colors;
+  colors.reserve(materials.size() * 4);
+  for (auto mat : materials) {
+    if (!mat)
+      continue;
+    colors.push_back(&mat->ambientColor);
+    colors.push_back(&mat->diffuseColor);
+    colors.push_back(&mat->specularColor);
+    colors.push_back(&mat->transformFilter);
+  }
+
+  vector<float> red(colors.size()), green(colors.size()), blue(colors.size());
+  for (size_t i = 0; i < colors.size(); ++i) {
+    red[i] = colors[i]->red;
+    green[i] = colors[i]->green;
+    blue[i] = colors[i]->blue;
+  }
+
+  mtlColorPass(red.data(), green.data(), blue.data(), colors.size(), flags);
+
+  for (size_t i = 0; i < colors.size(); ++i)
+    *colors[i] = { red[i], green[i], blue[i] };
+}
+
+/**
+ Returns the indices of all materials whose features word matches 'value'
+ in the bits set in 'mask', ordered by sort key. For example all
+ transparent materials:
+
+   queryMaterials(MF_TRANSPARENT, MF_TRANSPARENT)
+
+ or all materials with illum 2 and a diffuse map:
+
+   queryMaterials(MF_ILLUM_MASK | MF_MAP_KD, mtlIllumFeature(2) | MF_MAP_KD)
+ */
+vector<uint32_t>
+MtlObject::queryMaterials(uint32_t mask, uint32_t value) const
+{
+  return mtlQuerySortKeys(mSortKeys, mask, value);
+}
+
 static void
 skipOptionalChars(const string& data, string::size_type& pos)
 {
-  while ((data[pos] == '\'') || (data[pos] == ' ') || (data[pos] == '"'))
+  while ((pos < data.length()) &&
+      ((data[pos] == '\'') || (data[pos] == ' ') || (data[pos] == '"')))
     ++pos;
 }
 
@@ -104,6 +243,60 @@ parseParamInt(const string& data, string::size_type& pos,
   pos += left;
 }
 
+/**
+ Parses up to 'max' floats, stopping at the first token that is not a
+ number. Returns the number of floats parsed, at least one.
+ */
+static int
+parseParamFloats(const string& data, string::size_type& pos,
+    float value[], int max)
+{
+  int count = 0;
+
+  while (count < max) {
+    string::size_type localPos = pos;
+    skipOptionalChars(data, localPos);
+    if (localPos >= data.length())
+      break;
+
+    string::size_type endPos = data.find(" ", localPos);
+    string token(data.substr(localPos,
+        (endPos != string::npos ? endPos - localPos : endPos)));
+    string::size_type used = 0;
+    try {
+      value[count] = stof(token, &used);
+    } catch (exception& e) {
+      break;
+    }
+    if (used != token.length())
+      break;
+
+    ++count;
+    pos = (endPos != string::npos ? endPos : data.length());
+  }
+
+  if (!count)
+    throw MtlParseException();
+
+  return count;
+}
+
+/**
+ Parses the rest of the line, without trailing spaces, so that file names
+ may contain spaces
+ */
+static void
+parseParamFileName(const string& data, string::size_type& pos,
+    string& value)
+{
+  skipOptionalChars(data, pos);
+  string::size_type endPos = data.find_last_not_of(" \t\r");
+  if ((pos >= data.length()) || (endPos == string::npos) || (endPos < pos))
+    throw MtlParseException();
+  value = data.substr(pos, endPos + 1 - pos);
+  pos = data.length();
+}
+
 static void
 parseParamString(const string& data, string::size_type& pos,
     string& value)
@@ -111,67 +304,195 @@ parseParamString(const string& data, string::size_type& pos,
   skipOptionalChars(data, pos);
   string::size_type endPos = data.find(" ", pos);
   value = data.substr(pos, (endPos != string::npos ? endPos - pos : endPos));
-  pos = endPos;
+  pos = (endPos != string::npos ? endPos : data.length());
 }
 
 static void
 parseOptions(const string& data, string::size_type& pos,
     size_t nrOptions, const mtlOpt* options,
-    vector<tuple<const mtlOpt&, void *>>& values)
+    vector<tuple<const mtlOpt&, void *>>& values, MtlParseStats* stats)
 {
-  for (size_t i = 0; i < nrOptions; ++i) {
-    const string& option = options[i].optName;
-    const mtlOptType type = options[i].optType;
-    const string::size_type length = string(const_cast<const char *>(
-        options[i].optName)).length();
-    string::size_type localPos = 0;
-
-    if (data.compare(pos, length, option) || (data[pos + 1] != ' '))
-      continue;
+  bool matched = true;
 
-    localPos = pos + length;
+  /* Options may come in any order, keep matching until none does */
+  while (matched && (pos < data.length())) {
+    matched = false;
 
-    tuple<const mtlOpt&, void *> value(options[i], nullptr);
+    for (size_t i = 0; i < nrOptions; ++i) {
+      const string& option = options[i].optName;
+      const mtlOptType type = options[i].optType;
+      const string::size_type length = string(const_cast<const char *>(
+          options[i].optName)).length();
+      string::size_type localPos = 0;
+
+      if (data.compare(pos, length, option) || (data[pos + length] != ' '))
+        continue;
 
-    switch (type) {
-    case VT_EMPTY:
-      /* tuple value is already nullptr */
+      localPos = pos + length;
+
+      /* Values are added to 'values' before parsing, so that they are freed
+         by the caller if parsing throws */
+      tuple<const mtlOpt&, void *> value(options[i], nullptr);
+
+      switch (type) {
+      case VT_EMPTY:
+        /* tuple value is already nullptr */
+        values.push_back(value);
+        break;
+      case VT_2FLOATS:
+      case VT_3FLOATS:
+        {
+          int nrFloats = (type == VT_2FLOATS ? 2 : 3);
+          float* fVals = new float[nrFloats];
+          for (int j = 0; j < nrFloats; ++j)
+            fVals[j] = options[i].optDefault;
+          get<1>(value) = static_cast<void *>(fVals);
+          values.push_back(value);
+          STATS_ADD(stats, allocations, 1);
+          parseParamFloats(data, localPos, fVals, nrFloats);
+        }
+        break;
+      case VT_STRING:
+        {
+          string* sVal = new string();
+          get<1>(value) = static_cast<void *>(sVal);
+          values.push_back(value);
+          STATS_ADD(stats, allocations, 1);
+          parseParamString(data, localPos, *sVal);
+        }
+        break;
+      case VT_FLOAT:
+        {
+          float* fVal = new float(0);
+          get<1>(value) = static_cast<void *>(fVal);
+          values.push_back(value);
+          STATS_ADD(stats, allocations, 1);
+          parseParamFloat(data, localPos, *fVal);
+        }
+        break;
+      case VT_INT:
+        {
+          int* iVal = new int(0);
+          get<1>(value) = static_cast<void *>(iVal);
+          values.push_back(value);
+          STATS_ADD(stats, allocations, 1);
+          parseParamInt(data, localPos, *iVal);
+        }
+        break;
+      default:
+        if (MtlObject::verbose())
+          cerr << "Error parsing options" << endl;
+        throw MtlParseException();
+      }
+      pos = localPos;
+      skipOptionalChars(data, pos);
+      matched = true;
       break;
+    }
+  }
+}
+
+static void
+freeOptions(vector<tuple<const mtlOpt&, void *>>& values)
+{
+  for (auto& value : values) {
+    switch (get<0>(value).optType) {
+    case VT_2FLOATS:
     case VT_3FLOATS:
-      {
-        float* fVals = new float[3]{0};
-        parseParam3Floats(data, localPos, fVals);
-        get<1>(value) = static_cast<void *>(fVals);
-      }
+      delete[] static_cast<float *>(get<1>(value));
+      break;
+    case VT_STRING:
+      delete static_cast<string *>(get<1>(value));
       break;
     case VT_FLOAT:
-      {
-        float* fVal = new float(0);
-        parseParamFloat(data, localPos, *fVal);
-        get<1>(value) = static_cast<void *>(fVal);
-      }
+      delete static_cast<float *>(get<1>(value));
       break;
     case VT_INT:
-      {
-        int* iVal = new int(0);
-        parseParamInt(data, localPos, *iVal);
-        get<1>(value) = static_cast<void *>(iVal);
-      }
+      delete static_cast<int *>(get<1>(value));
       break;
     default:
-      cerr << "Error parsing options" << endl;
-      throw MtlParseException();
+      break;
     }
-    cout << "Adding tuple ("<< get<0>(value).optName << ", " << get<1>(value) << ")" << endl;
-    values.push_back(value);
   }
+  values.clear();
+}
+
+static bool
+isOn(const string& value)
+{
+  return value == "on";
 }
 
+/**
+ Sets 'map' from a parsed map statement, options without a matching field
+ in MtlMap (-boost, -cc, -bm) are ignored
+ */
 static void
-parseLine(vector<MtlMaterial *>& materials, const string& data)
+applyMap(MtlMap& map, const string& fileName,
+    const vector<tuple<const mtlOpt&, void *>>& options)
+{
+  map.fileName = fileName;
+
+  for (const auto& option : options) {
+    const string name(get<0>(option).optName);
+    const float* fVals = static_cast<const float *>(get<1>(option));
+    const string* sVal = static_cast<const string *>(get<1>(option));
+
+    if (name == "-blendu") {
+      map.blendU = isOn(*sVal);
+    } else if (name == "-blendv") {
+      map.blendV = isOn(*sVal);
+    } else if (name == "-clamp") {
+      map.clamp = isOn(*sVal);
+    } else if (name == "-imfchan") {
+      switch (sVal->empty() ? '\0' : (*sVal)[0]) {
+      case 'r': map.imfChan = r; break;
+      case 'g': map.imfChan = g; break;
+      case 'b': map.imfChan = b; break;
+      case 'm': map.imfChan = m; break;
+      case 'l': map.imfChan = l; break;
+      case 'z': map.imfChan = z; break;
+      default: throw MtlParseException();
+      }
+    } else if (name == "-mm") {
+      map.mm[0] = fVals[0];
+      map.mm[1] = fVals[1];
+    } else if ((name == "-o") || (name == "-s") || (name == "-t")) {
+      float* target = (name == "-o" ? map.offset :
+          (name == "-s" ? map.scale : map.turbulence));
+      for (int i = 0; i < 3; ++i)
+        target[i] = fVals[i];
+    } else if (name == "-texres") {
+      /* Either "size" or "width" + "x" + "height" */
+      string::size_type x = sVal->find('x');
+      map.textureResolution[0] = stoi(sVal->substr(0, x));
+      map.textureResolution[1] = (x != string::npos ?
+          stoi(sVal->substr(x + 1)) : map.textureResolution[0]);
+    }
+  }
+}
+
+/** Case insensitive compare, exporters disagree on e.g. 'map_Ka'/'map_kA' */
+static bool
+matchesKey(const string& data, string::size_type pos, const char* keyName,
+    string::size_type keyNameSize)
+{
+  if (data.length() - pos < keyNameSize)
+    return false;
+  for (string::size_type i = 0; i < keyNameSize; ++i) {
+    if (tolower(static_cast<unsigned char>(data[pos + i])) !=
+        tolower(static_cast<unsigned char>(keyName[i])))
+      return false;
+  }
+  return true;
+}
+
+static void
+parseLine(vector<MtlMaterial *>& materials, const string& data,
+    MtlParseStats* stats)
 {
   /*
-  MtlColor ambientColor, diffuseColor, specularColor; // Ka, Kd, Ks (3 * [0 - 255])
+  MtlColor ambientColor, diffuseColor, specularColor; // Ka, Kd, Ks (3 * [0 - 1] or [0 - 255])
   int illumination; // illum
   float dissolve; // d (0.0 - 1.0)
   float specularExponent; // Ns (0 - 1000)
@@ -194,17 +515,26 @@ parseLine(vector<MtlMaterial *>& materials, const string& data)
   if (pos == data.find(MATERIAL_SENINTEL, pos)) {
     pos += MATERIAL_SENINTEL_LEN;
     MtlMaterial *mat = new MtlMaterial();
+    STATS_ADD(stats, allocations, 1);
+    STATS_ADD(stats, materialLines, 1);
     skipOptionalChars(data, pos);
-    mat->name = data.substr(pos);
+    /* Without trailing blanks or '\r' of CRLF files, 'usemtl' lines in OBJ
+       files are trimmed the same way */
+    string::size_type endPos = data.find_last_not_of(" \t\r");
+    mat->name = (endPos != string::npos && endPos >= pos ?
+        data.substr(pos, endPos + 1 - pos) : string());
     materials.push_back(mat);
-    cout << "Created material '" << mat->name << "'" << endl;
+    if (MtlObject::verbose())
+      cout << "Created material '" << mat->name << "'" << endl;
     return;
   }
 
   /* If no newmtl have been found previously then the file is erroneous,
      since we have nothing to add found properties to */
   if (!materials.size()) {
-    cerr << "No material yet in Mtl file, skipping line" << endl;
+    if (MtlObject::verbose())
+      cerr << "No material yet in Mtl file, skipping line" << endl;
+    STATS_ADD(stats, skippedLines, 1);
     return;
   }
 
@@ -213,19 +543,23 @@ parseLine(vector<MtlMaterial *>& materials, const string& data)
 
   string opts;
 
+  /* Keyword matching is the time spent in here minus parsing */
+  auto keywordStart = STATS_NOW(stats);
+  uint64_t parseTime = 0;
+
   /* Go through the list of valid keys */
   bool keyMatched = false;
   for (const auto& k : keys) {
     string::size_type keyNameSize = string(k.keyName).length();
 
     /* Try to match the parameter name with a valid key */
-    if (((data.compare(pos, keyNameSize, k.keyName)) != 0) ||
-        (data[keyNameSize] != ' '))
+    if (!matchesKey(data, pos, k.keyName, keyNameSize) ||
+        (data[pos + keyNameSize] != ' '))
       continue;
 
     keyMatched = true;
+    STATS_ADD(stats, keyLines[&k - keys], 1);
 
-    cout << "Matched key: " << k.keyName << endl;
     pos += keyNameSize;
     skipOptionalChars(data, pos);
 
@@ -242,44 +576,53 @@ parseLine(vector<MtlMaterial *>& materials, const string& data)
 
       valueMatched = true;
 
-      cout << "Matched value: " << (v.valName ? v.valName : "unnamed") << endl;
       pos += valNameSize;
       skipOptionalChars(data, pos);
 
+      vector<tuple<const mtlOpt&, void *>> optionsBuffer;
       try {
         float floatData[3] = {0};
         int intData[3] = {0};
         string stringData;
-        vector<tuple<const mtlOpt&, void *>> optionsBuffer;
+
+        auto optionStart = STATS_NOW(stats);
+        parseOptions(data, pos, k.nrOptions, k.options, optionsBuffer, stats);
+        if (STATS_ENABLED(stats)) {
+          uint64_t optionTime = elapsed(optionStart);
+          stats->optionTime += optionTime;
+          parseTime += optionTime;
+        }
 
         /* Parse by value type */
+        auto valueStart = STATS_NOW(stats);
         switch (v.valType) {
         case VT_FLOAT:
-          cout << "Parsing float for " << k.keyName << endl;
-          parseOptions(data, pos, k.nrOptions, k.options, optionsBuffer);
           parseParamFloat(data, pos, floatData[0]);
           break;
         case VT_3FLOATS:
-          cout << "Parsing float[3] for " << k.keyName << endl;
-          parseOptions(data, pos, k.nrOptions, k.options, optionsBuffer);
           parseParam3Floats(data, pos, floatData);
           break;
         case VT_INT:
-          cout << "Parsing int for " << k.keyName << endl;
-          parseOptions(data, pos, k.nrOptions, k.options, optionsBuffer);
           parseParamInt(data, pos, intData[0]);
           break;
         case VT_STRING_AND_FLOAT:
-          cout << "Parsing int for " << k.keyName << endl;
-          parseOptions(data, pos, k.nrOptions, k.options, optionsBuffer);
           parseParamString(data, pos, stringData);
           break;
+        case VT_STRING:
+          parseParamFileName(data, pos, stringData);
+          break;
         default:
-          cerr << "Fatal error, invalid value type (\"" <<
-              (v.valName ? v.valName : "unnamed") << "\", " << v.valType
-              << ")" << endl;
+          if (MtlObject::verbose())
+            cerr << "Fatal error, invalid value type (\"" <<
+                (v.valName ? v.valName : "unnamed") << "\", " << v.valType
+                << ")" << endl;
           throw MtlParseException();
         }
+        if (STATS_ENABLED(stats)) {
+          uint64_t valueTime = elapsed(valueStart);
+          stats->valueTime += valueTime;
+          parseTime += valueTime;
+        }
 
         /* Set to appropriate field in material object */
         switch (k.keyType) {
@@ -300,24 +643,53 @@ parseLine(vector<MtlMaterial *>& materials, const string& data)
           break;
         case KT_D:
           mat.dissolve = floatData[0];
+          for (const auto& option : optionsBuffer) {
+            if (&get<0>(option) == &dOpts)
+              mat.dissolveHalo = true;
+          }
           break;
         case KT_NS:
           mat.specularExponent = intData[0];
           break;
+        case KT_MAPKA:
+          applyMap(mat.mapAmbientColor, stringData, optionsBuffer);
+          break;
+        case KT_MAPKD:
+          applyMap(mat.mapDiffuseColor, stringData, optionsBuffer);
+          break;
+        case KT_MAPKS:
+          applyMap(mat.mapSpecularColor, stringData, optionsBuffer);
+          break;
+        case KT_MAPNS:
+          applyMap(mat.mapSpecularExponent, stringData, optionsBuffer);
+          break;
+        case KT_DECAL:
+          applyMap(mat.decal, stringData, optionsBuffer);
+          break;
+        case KT_DISP:
+          applyMap(mat.disposition, stringData, optionsBuffer);
+          break;
+        case KT_MAPAAT:
+          mat.mapAntiAliasingTextures = isOn(stringData);
+          break;
         default:
-          cerr << "Fatal error, invalid key type (" << k.keyType << ")" <<
-              endl;
+          if (MtlObject::verbose())
+            cerr << "Fatal error, invalid key type (" << k.keyType << ")" <<
+                endl;
         }
+        freeOptions(optionsBuffer);
       } catch(exception& e) {
-        cerr << "Failed parsing '" << k.keyName << "' value(s) from material"
-            << endl;
+        freeOptions(optionsBuffer);
+        STATS_ADD(stats, valueFailures, 1);
+        if (MtlObject::verbose())
+          cerr << "Failed parsing '" << k.keyName <<
+              "' value(s) from material" << endl;
       }
 
       /* If we have matched the parameters value with a valid key value then do
          not continue searching for a matching key value */
       if (valueMatched)
       {
-        cout << "--- DONE VAL" << endl;
         break;
       }
 
@@ -327,11 +699,14 @@ parseLine(vector<MtlMaterial *>& materials, const string& data)
        searching for a matching key */
     if (keyMatched)
     {
-      cout << "--- DONE KEY" << endl;
       break;
     }
 
   } /* for keys */
+
+  if (!keyMatched)
+    STATS_ADD(stats, unmatchedLines, 1);
+  STATS_ADD(stats, keywordTime, elapsed(keywordStart) - parseTime);
 }
 
 
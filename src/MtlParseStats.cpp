@@ -0,0 +1,55 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <cstddef>
+#include <iostream>
+
+#include "MtlObject_int.hpp"
+#include "MtlParseStats.hpp"
+
+using namespace std;
+
+static_assert(sizeof(keys) / sizeof(keys[0]) <= MTL_STATS_MAX_KEYS,
+    "MTL_STATS_MAX_KEYS is smaller than the key table");
+
+MtlParseStats::MtlParseStats(void) :
+    bytesRead(0), linesRead(0), materialLines(0), keyLines(),
+    unmatchedLines(0), skippedLines(0), valueFailures(0), allocations(0),
+    ioTime(0), keywordTime(0), valueTime(0), optionTime(0)
+{}
+
+/**
+ Returns the name of the key counted in keyLines[index], or nullptr if
+ no key uses that index
+ */
+const char*
+MtlParseStats::keyName(size_t index)
+{
+  return (index < sizeof(keys) / sizeof(keys[0]) ? keys[index].keyName :
+      nullptr);
+}
+
+void
+MtlParseStats::printJson(ostream& out) const
+{
+  out << "{" << endl;
+  out << "  \"bytesRead\": " << bytesRead << "," << endl;
+  out << "  \"linesRead\": " << linesRead << "," << endl;
+  out << "  \"keyLines\": {" << endl;
+  out << "    \"newmtl\": " << materialLines;
+  for (size_t i = 0; keyName(i); ++i)
+    out << "," << endl << "    \"" << keyName(i) << "\": " << keyLines[i];
+  out << endl << "  }," << endl;
+  out << "  \"unmatchedLines\": " << unmatchedLines << "," << endl;
+  out << "  \"skippedLines\": " << skippedLines << "," << endl;
+  out << "  \"valueFailures\": " << valueFailures << "," << endl;
+  out << "  \"allocations\": " << allocations << "," << endl;
+  out << "  \"timeNs\": {" << endl;
+  out << "    \"io\": " << ioTime << "," << endl;
+  out << "    \"keyword\": " << keywordTime << "," << endl;
+  out << "    \"value\": " << valueTime << "," << endl;
+  out << "    \"option\": " << optionTime << endl;
+  out << "  }" << endl;
+  out << "}" << endl;
+}
@@ -0,0 +1,233 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "MtlObject.hpp"
+#include "MtlReader.h"
+
+using namespace std;
+
+struct mtlHandle {
+  vector<float> colors[CS_COUNT];
+  vector<int32_t> illumination;
+  vector<float> dissolve;
+  vector<uint8_t> dissolveHalo;
+  vector<int32_t> specularExponent;
+  vector<int32_t> sharpness;
+  vector<float> opticalDensity;
+  vector<uint8_t> mapAntiAliasingTextures;
+  vector<uint64_t> sortKeys;
+  string strings;
+  vector<uint32_t> nameOffsets;
+  vector<uint32_t> mapOffsets[MS_COUNT];
+};
+
+static uint32_t
+addString(string& strings, const string& value)
+{
+  if (value.empty())
+    return 0;
+
+  uint32_t offset = static_cast<uint32_t>(strings.size());
+  strings.append(value);
+  strings.push_back('\0');
+  return offset;
+}
+
+static void
+addColor(vector<float>& colors, const MtlColor& color)
+{
+  colors.push_back(color.red);
+  colors.push_back(color.green);
+  colors.push_back(color.blue);
+}
+
+/**
+ Flattens 'object' into a new handle. Material indices in the sort keys
+ refer to 'object.materials', which never holds nullptr after parsing.
+ */
+static mtlHandle*
+createHandle(const MtlObject& object)
+{
+  mtlHandle* handle = new mtlHandle();
+  size_t count = object.materials.size();
+
+  for (auto& colors : handle->colors)
+    colors.reserve(count * 3);
+  handle->illumination.reserve(count);
+  handle->dissolve.reserve(count);
+  handle->dissolveHalo.reserve(count);
+  handle->specularExponent.reserve(count);
+  handle->sharpness.reserve(count);
+  handle->opticalDensity.reserve(count);
+  handle->mapAntiAliasingTextures.reserve(count);
+  handle->nameOffsets.reserve(count);
+  for (auto& offsets : handle->mapOffsets)
+    offsets.reserve(count);
+
+  /* Offset 0 is the empty string */
+  handle->strings.push_back('\0');
+
+  for (const auto mat : object.materials) {
+    addColor(handle->colors[CS_KA], mat->ambientColor);
+    addColor(handle->colors[CS_KD], mat->diffuseColor);
+    addColor(handle->colors[CS_KS], mat->specularColor);
+    addColor(handle->colors[CS_TF], mat->transformFilter);
+    handle->illumination.push_back(mat->illumination);
+    handle->dissolve.push_back(mat->dissolve);
+    handle->dissolveHalo.push_back(mat->dissolveHalo);
+    handle->specularExponent.push_back(mat->specularExponent);
+    handle->sharpness.push_back(mat->sharpness);
+    handle->opticalDensity.push_back(mat->opticalDensity);
+    handle->mapAntiAliasingTextures.push_back(mat->mapAntiAliasingTextures);
+    handle->nameOffsets.push_back(addString(handle->strings, mat->name));
+    handle->mapOffsets[MS_KA].push_back(addString(handle->strings,
+        mat->mapAmbientColor.fileName));
+    handle->mapOffsets[MS_KD].push_back(addString(handle->strings,
+        mat->mapDiffuseColor.fileName));
+    handle->mapOffsets[MS_KS].push_back(addString(handle->strings,
+        mat->mapSpecularColor.fileName));
+    handle->mapOffsets[MS_NS].push_back(addString(handle->strings,
+        mat->mapSpecularExponent.fileName));
+    handle->mapOffsets[MS_DECAL].push_back(addString(handle->strings,
+        mat->decal.fileName));
+    handle->mapOffsets[MS_DISP].push_back(addString(handle->strings,
+        mat->disposition.fileName));
+  }
+
+  handle->sortKeys = object.sortKeys();
+
+  return handle;
+}
+
+extern "C" {
+
+mtlHandle*
+mtlOpenFile(const char* fileName)
+{
+  try {
+    ifstream dataFile(fileName);
+    if (!dataFile.is_open())
+      return nullptr;
+
+    MtlObject object(dataFile, fileName);
+    return createHandle(object);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+mtlHandle*
+mtlOpenBuffer(const char* data, size_t size)
+{
+  try {
+    istringstream dataStream(string(data, size));
+    MtlObject object(dataStream);
+    return createHandle(object);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void
+mtlClose(mtlHandle* handle)
+{
+  delete handle;
+}
+
+void
+mtlSetVerbose(int verbose)
+{
+  MtlObject::setVerbose(verbose != 0);
+}
+
+size_t
+mtlMaterialCount(const mtlHandle* handle)
+{
+  return handle->nameOffsets.size();
+}
+
+const float*
+mtlColors(const mtlHandle* handle, mtlColorSlot slot)
+{
+  return ((slot >= 0) && (slot < CS_COUNT) ? handle->colors[slot].data() :
+      nullptr);
+}
+
+const int32_t*
+mtlIllumination(const mtlHandle* handle)
+{
+  return handle->illumination.data();
+}
+
+const float*
+mtlDissolve(const mtlHandle* handle)
+{
+  return handle->dissolve.data();
+}
+
+const uint8_t*
+mtlDissolveHalo(const mtlHandle* handle)
+{
+  return handle->dissolveHalo.data();
+}
+
+const int32_t*
+mtlSpecularExponent(const mtlHandle* handle)
+{
+  return handle->specularExponent.data();
+}
+
+const int32_t*
+mtlSharpness(const mtlHandle* handle)
+{
+  return handle->sharpness.data();
+}
+
+const float*
+mtlOpticalDensity(const mtlHandle* handle)
+{
+  return handle->opticalDensity.data();
+}
+
+const uint8_t*
+mtlMapAntiAliasingTextures(const mtlHandle* handle)
+{
+  return handle->mapAntiAliasingTextures.data();
+}
+
+const uint64_t*
+mtlSortKeys(const mtlHandle* handle)
+{
+  return handle->sortKeys.data();
+}
+
+const char*
+mtlStringTable(const mtlHandle* handle, size_t* size)
+{
+  if (size)
+    *size = handle->strings.size();
+  return handle->strings.data();
+}
+
+const uint32_t*
+mtlNameOffsets(const mtlHandle* handle)
+{
+  return handle->nameOffsets.data();
+}
+
+const uint32_t*
+mtlMapOffsets(const mtlHandle* handle, mtlMapSlot slot)
+{
+  return ((slot >= 0) && (slot < MS_COUNT) ? handle->mapOffsets[slot].data() :
+      nullptr);
+}
+
+} /* extern "C" */
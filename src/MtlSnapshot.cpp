@@ -0,0 +1,155 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MtlSnapshot.hpp"
+
+using namespace std;
+
+static vector<MtlMaterial>
+copyMaterials(const MtlObject& object)
+{
+  vector<MtlMaterial> materials;
+  materials.reserve(object.materials.size());
+  for (const auto mat : object.materials) {
+    if (mat)
+      materials.push_back(*mat);
+  }
+  return materials;
+}
+
+static vector<uint64_t>
+buildSortKeys(const vector<MtlMaterial>& materials)
+{
+  vector<uint64_t> keys;
+  keys.reserve(materials.size());
+  for (uint32_t i = 0; i < materials.size(); ++i)
+    keys.push_back(mtlMaterialSortKey(materials[i], i));
+  mtlRadixSort(keys);
+  return keys;
+}
+
+MtlSnapshot::MtlSnapshot(void)
+{}
+
+MtlSnapshot::MtlSnapshot(const MtlObject& object) :
+    fileName(object.mFileName), materials(copyMaterials(object)),
+    sortKeys(buildSortKeys(materials))
+{}
+
+/**
+ Returns the indices of all materials whose features word matches 'value'
+ in the bits set in 'mask', ordered by sort key
+ */
+vector<uint32_t>
+MtlSnapshot::queryMaterials(uint32_t mask, uint32_t value) const
+{
+  return mtlQuerySortKeys(sortKeys, mask, value);
+}
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+    "MtlLibrary readers need lock-free atomic counters");
+
+MtlLibrary::MtlLibrary(void) : mCurrent(0)
+{
+  mSlots[0] = make_shared<const MtlSnapshot>();
+  mReaders[0].store(0);
+  mReaders[1].store(0);
+}
+
+/**
+ Starts with the library in 'fileName', or an empty snapshot if it cannot
+ be opened
+ */
+MtlLibrary::MtlLibrary(const string& fileName) : MtlLibrary()
+{
+  reload(fileName);
+}
+
+/**
+ Returns the current snapshot, never nullptr. Lock-free: the slot is only
+ copied while it is counted in mReaders and still current, which keeps
+ publish() from changing it during the copy.
+ */
+shared_ptr<const MtlSnapshot>
+MtlLibrary::snapshot(void) const
+{
+  for (;;) {
+    unsigned int slot = mCurrent.load();
+    mReaders[slot].fetch_add(1);
+
+    /* A publish in between may be about to change this slot, retry */
+    if (mCurrent.load() == slot) {
+      shared_ptr<const MtlSnapshot> snapshot(mSlots[slot]);
+      mReaders[slot].fetch_sub(1);
+      return snapshot;
+    }
+
+    mReaders[slot].fetch_sub(1);
+  }
+}
+
+/**
+ Waits until no reader is copying from 'slot'. Only called for a slot that
+ is not current, so readers arriving later back off without copying.
+ */
+void
+MtlLibrary::waitForReaders(unsigned int slot) const
+{
+  while (mReaders[slot].load())
+    this_thread::yield();
+}
+
+/**
+ Makes 'snapshot' the current snapshot. Readers still holding the previous
+ one keep it alive until they drop it; the library drops its own reference
+ right away.
+ */
+void
+MtlLibrary::publish(shared_ptr<const MtlSnapshot> snapshot)
+{
+  if (!snapshot)
+    return;
+
+  lock_guard<mutex> lock(mPublishMutex);
+  unsigned int previous = mCurrent.load();
+  unsigned int next = 1 - previous;
+
+  waitForReaders(next);
+  mSlots[next] = snapshot;
+  mCurrent.store(next);
+
+  waitForReaders(previous);
+  mSlots[previous].reset();
+}
+
+/**
+ Parses 'fileName' and publishes it as the new snapshot. The parse happens
+ entirely outside of the shared state, readers keep seeing the previous
+ snapshot until it is done. Returns false, and publishes nothing, if the
+ file cannot be opened.
+ */
+bool
+MtlLibrary::reload(const string& fileName)
+{
+  ifstream dataFile(fileName);
+  if (!dataFile.is_open()) {
+    if (MtlObject::verbose())
+      cerr << "Failed to open file '" << fileName << "'" << endl;
+    return false;
+  }
+
+  MtlObject object(dataFile, fileName);
+  publish(make_shared<const MtlSnapshot>(object));
+
+  return true;
+}
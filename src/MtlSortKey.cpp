@@ -0,0 +1,83 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MtlSortKey.hpp"
+
+using namespace std;
+
+uint64_t
+mtlMaterialSortKey(const MtlMaterial& mat, uint32_t index)
+{
+  uint32_t features = mtlIllumFeature(mat.illumination);
+
+  if ((mat.dissolve < 1.0f) || mat.dissolveHalo)
+    features |= MF_TRANSPARENT;
+  if (!mat.mapAmbientColor.fileName.empty())
+    features |= MF_MAP_KA;
+  if (!mat.mapDiffuseColor.fileName.empty())
+    features |= MF_MAP_KD;
+  if (!mat.mapSpecularColor.fileName.empty())
+    features |= MF_MAP_KS;
+  if (!mat.mapSpecularExponent.fileName.empty())
+    features |= MF_MAP_NS;
+  if (!mat.decal.fileName.empty())
+    features |= MF_DECAL;
+  if (!mat.disposition.fileName.empty())
+    features |= MF_DISP;
+  if (mat.mapAntiAliasingTextures)
+    features |= MF_MAP_AAT;
+
+  return (static_cast<uint64_t>(features) << 32) | index;
+}
+
+/**
+ LSD radix sort, one byte per pass. Passes where every key has the same
+ byte (most of them, since the features word is sparse) are skipped.
+ */
+void
+mtlRadixSort(vector<uint64_t>& keys)
+{
+  vector<uint64_t> buffer(keys.size());
+
+  for (unsigned int shift = 0; shift < 64; shift += 8) {
+    size_t counts[256] = {0};
+
+    for (const auto key : keys)
+      ++counts[(key >> shift) & 0xff];
+
+    /* All keys share this byte, nothing to reorder */
+    if (counts[(keys.empty() ? 0 : (keys[0] >> shift) & 0xff)] ==
+        keys.size())
+      continue;
+
+    size_t offset = 0;
+    for (unsigned int i = 0; i < 256; ++i) {
+      size_t count = counts[i];
+      counts[i] = offset;
+      offset += count;
+    }
+
+    for (const auto key : keys)
+      buffer[counts[(key >> shift) & 0xff]++] = key;
+
+    keys.swap(buffer);
+  }
+}
+
+/**
+ Returns the material indices of all keys in 'sortedKeys' whose features
+ word matches 'value' in the bits set in 'mask', in key order
+ */
+vector<uint32_t>
+mtlQuerySortKeys(const vector<uint64_t>& sortedKeys, uint32_t mask,
+    uint32_t value)
+{
+  return mtlQuerySortKeys(sortedKeys, [mask, value](uint32_t features) {
+    return (features & mask) == value;
+  });
+}
@@ -0,0 +1,184 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ObjMtlResolver.hpp"
+
+#define FACE_SENTINEL "f"
+#define FACE_SENTINEL_LEN 1
+#define MTLLIB_SENTINEL "mtllib"
+#define MTLLIB_SENTINEL_LEN 6
+#define USEMTL_SENTINEL "usemtl"
+#define USEMTL_SENTINEL_LEN 6
+
+using namespace std;
+
+static bool
+isBlank(char c)
+{
+  return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+/**
+ Returns true if the line 'data' starting at 'pos' begins with the
+ statement 'keyword', and moves 'pos' to the first argument
+ */
+static bool
+matchStatement(const string& data, string::size_type& pos,
+    const char* keyword, string::size_type keywordLen)
+{
+  if (data.compare(pos, keywordLen, keyword) ||
+      ((pos + keywordLen < data.length()) && !isBlank(data[pos + keywordLen])))
+    return false;
+
+  pos += keywordLen;
+  while ((pos < data.length()) && isBlank(data[pos]))
+    ++pos;
+
+  return true;
+}
+
+ObjMtlResolver::ObjMtlResolver(const string& fileName) :
+    mFileName(fileName), mFaceCount(0)
+{
+  ifstream dataFile(fileName);
+  string line;
+  if (!dataFile.is_open() && MtlObject::verbose()) {
+    cerr << "Failed to open file '" << fileName << "'" << endl;
+  }
+
+  string::size_type slash = fileName.find_last_of('/');
+  if (slash != string::npos)
+    mBaseDir = fileName.substr(0, slash + 1);
+
+  /* Faces before the first 'usemtl' have no material */
+  ranges.push_back({ -1, 0, 0 });
+
+  while (getline(dataFile, line))
+  {
+    string::size_type pos = 0;
+    while ((pos < line.length()) && isBlank(line[pos]))
+      ++pos;
+
+    /* Only look at the statement, geometry is never parsed */
+    switch (pos < line.length() ? line[pos] : '\0') {
+    case 'f':
+      if (matchStatement(line, pos, FACE_SENTINEL, FACE_SENTINEL_LEN)) {
+        ++ranges.back().faceCount;
+        ++mFaceCount;
+      }
+      break;
+    case 'm':
+      if (matchStatement(line, pos, MTLLIB_SENTINEL, MTLLIB_SENTINEL_LEN)) {
+        /* One or more space separated file names */
+        while (pos < line.length()) {
+          string::size_type endPos = pos;
+          while ((endPos < line.length()) && !isBlank(line[endPos]))
+            ++endPos;
+          loadLibrary(line.substr(pos, endPos - pos));
+          pos = endPos;
+          while ((pos < line.length()) && isBlank(line[pos]))
+            ++pos;
+        }
+      }
+      break;
+    case 'u':
+      if (matchStatement(line, pos, USEMTL_SENTINEL, USEMTL_SENTINEL_LEN)) {
+        string::size_type endPos = line.find_last_not_of(" \t\r");
+        useMaterial(line.substr(pos, (endPos != string::npos && endPos >= pos ?
+            endPos + 1 - pos : 0)));
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  /* Drop the leading material-less range and a trailing 'usemtl' if no
+     faces used them */
+  if (!ranges.front().faceCount)
+    ranges.erase(ranges.begin());
+  if (!ranges.empty() && !ranges.back().faceCount)
+    ranges.pop_back();
+
+  dataFile.close();
+}
+
+ObjMtlResolver::~ObjMtlResolver(void)
+{
+  for (auto lib : libraries)
+    delete lib;
+  libraries.clear();
+}
+
+void
+ObjMtlResolver::printRanges(void)
+{
+  cout << "Object '" << mFileName << "'" << endl;
+  for (unsigned int i = 0; i < ranges.size(); ++i) {
+    const ObjMtlRange& range = ranges[i];
+    cout << " " << (((i + 1) == ranges.size()) ? "└─" : "├─") << "Faces " <<
+        range.firstFace << " - " << (range.firstFace + range.faceCount) <<
+        ": " << (range.materialIndex < 0 ? "(none)" :
+        materials[range.materialIndex]->name) << " (" <<
+        range.materialIndex << ")" << endl;
+  }
+}
+
+/**
+ Loads the MTL file 'fileName', relative to the OBJ file, unless it has
+ already been loaded and appends its materials to the material table.
+ Materials already defined by an earlier library keep their index.
+ */
+void
+ObjMtlResolver::loadLibrary(const string& fileName)
+{
+  string path((fileName.length() && fileName[0] == '/') ? fileName :
+      mBaseDir + fileName);
+
+  if (!mLoadedLibraries.insert(path).second)
+    return;
+
+  MtlObject* lib = new MtlObject(path);
+  libraries.push_back(lib);
+
+  for (const auto mat : lib->materials) {
+    if (!mat || mMaterialIndices.count(mat->name))
+      continue;
+    mMaterialIndices[mat->name] = static_cast<int>(materials.size());
+    materials.push_back(mat);
+  }
+}
+
+/**
+ Starts a new face range for the material 'name'. Consecutive ranges with
+ the same material are merged and empty ranges are reused.
+ */
+void
+ObjMtlResolver::useMaterial(const string& name)
+{
+  auto it = mMaterialIndices.find(name);
+  int index = (it != mMaterialIndices.end() ? it->second : -1);
+
+  if ((it == mMaterialIndices.end()) && MtlObject::verbose())
+    cerr << "Unknown material '" << name << "' in '" << mFileName << "'" <<
+        endl;
+
+  ObjMtlRange& last = ranges.back();
+  if (last.materialIndex == index)
+    return;
+
+  if (!last.faceCount && (ranges.size() > 1)) {
+    last.materialIndex = index;
+    /* Reusing the empty range may make it a continuation of the one before */
+    if (ranges[ranges.size() - 2].materialIndex == index)
+      ranges.pop_back();
+    return;
+  }
+
+  ranges.push_back({ index, mFaceCount, 0 });
+}
@@ -2,20 +2,62 @@
  * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
  */
 
+#include <fstream>
 #include <iostream>
 #include <list>
 #include <string>
 
 #include "MtlObject.hpp"
+#include "MtlParseStats.hpp"
 
 using namespace std;
 
+static void
+usage(const char* prog)
+{
+  cerr << "Usage: " << prog << " [-v] [-s statsfile] [file]" << endl;
+  cerr << "  -v            Print diagnostics while parsing" << endl;
+  cerr << "  -s statsfile  Write parse statistics as JSON to statsfile" <<
+      endl;
+  cerr << "  file          MTL file to read (default: test.mtl)" << endl;
+}
+
 int
 main(int argc, char *argv[])
 {
-  MtlObject mtl("test.mtl");
+  string fileName("test.mtl");
+  string statsFileName;
+
+  for (int i = 1; i < argc; ++i) {
+    string arg(argv[i]);
+    if ((arg == "-s") && (i + 1 < argc)) {
+      statsFileName = argv[++i];
+    } else if (arg == "-v") {
+      MtlObject::setVerbose(true);
+    } else if (arg == "-h") {
+      usage(argv[0]);
+      return 0;
+    } else if (!arg.empty() && arg[0] == '-') {
+      usage(argv[0]);
+      return 1;
+    } else {
+      fileName = arg;
+    }
+  }
+
+  MtlParseStats stats;
+  MtlObject mtl(fileName, (statsFileName.empty() ? nullptr : &stats));
   mtl.printMaterials();
 
+  /* Written to a file of its own, stdout has the material tree */
+  if (!statsFileName.empty()) {
+    ofstream statsFile(statsFileName);
+    if (!statsFile.is_open()) {
+      cerr << "Failed to open file '" << statsFileName << "'" << endl;
+      return 1;
+    }
+    stats.printJson(statsFile);
+  }
+
   return 0;
 }
-
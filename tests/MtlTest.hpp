@@ -0,0 +1,22 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#ifndef MTLTEST_HPP
+#define MTLTEST_HPP
+
+#include <iostream>
+
+/** Number of failed checks, the test exits with it */
+static int testFailures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond \
+          ") failed" << std::endl; \
+      ++testFailures; \
+    } \
+  } while (0)
+
+#endif /* MTLTEST_HPP */
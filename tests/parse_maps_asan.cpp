@@ -0,0 +1,100 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+/* Built with -fsanitize=address, see the Makefile 'test' target */
+
+#include <sstream>
+#include <string>
+
+#include "MtlObject.hpp"
+#include "MtlTest.hpp"
+
+using namespace std;
+
+/** Parses 'data' as an MTL file and returns the number of value failures */
+static uint64_t
+parse(const string& data, MtlParseStats& stats)
+{
+  istringstream stream(data);
+  MtlObject mtl(stream, "buffer", &stats);
+  return stats.valueFailures;
+}
+
+static void
+testMaps(void)
+{
+  istringstream data("newmtl a\n"
+      "map_Kd -clamp on -imfchan r -mm 0.5 -s 2 -o 1 2 3 -bm 0.3 t d.png\n"
+      "decal -texres 64x32 -blendu off decal.png\r\n"
+      "map_aat on\n");
+  MtlObject mtl(data);
+
+  CHECK(mtl.materials.size() == 1);
+  if (mtl.materials.size() != 1)
+    return;
+
+  const MtlMaterial& mat = *mtl.materials[0];
+  CHECK(mat.mapDiffuseColor.fileName == "t d.png");
+  CHECK(mat.mapDiffuseColor.clamp);
+  CHECK(mat.mapDiffuseColor.imfChan == r);
+  CHECK(mat.mapDiffuseColor.mm[0] == 0.5f && mat.mapDiffuseColor.mm[1] == 1.0f);
+  CHECK(mat.mapDiffuseColor.scale[0] == 2.0f);
+  CHECK(mat.mapDiffuseColor.scale[1] == 1.0f);
+  CHECK(mat.mapDiffuseColor.offset[2] == 3.0f);
+  CHECK(mat.decal.fileName == "decal.png");
+  CHECK(mat.decal.textureResolution[0] == 64);
+  CHECK(mat.decal.textureResolution[1] == 32);
+  CHECK(!mat.decal.blendU && mat.decal.blendV);
+  CHECK(mat.mapAntiAliasingTextures);
+}
+
+/** Lines ending in an option value, without a file name */
+static void
+testTruncated(void)
+{
+  static const char* lines[] = {
+    "map_Kd -clamp on",
+    "map_Kd -blendu on",
+    "map_Kd -blendv off ",
+    "map_Kd -imfchan m",
+    "map_Kd -texres 512",
+    "map_Kd -bm 0.5",
+    "map_Kd -mm 0 1",
+    "map_Kd -s 1 1 1",
+  };
+
+  for (const auto line : lines) {
+    MtlParseStats stats;
+    CHECK(parse(string("newmtl a\n") + line + "\n", stats) == 1);
+    CHECK(parse(string("newmtl a\n") + line, stats) == 2);
+  }
+}
+
+/** Option values that fail to parse, their allocations must be freed */
+static void
+testBadValues(void)
+{
+  static const char* lines[] = {
+    "map_Kd -bm abc t.png",
+    "map_Kd -boost x t.png",
+    "map_Kd -s abc t.png",
+    "map_Kd -imfchan q t.png",
+    "map_Kd -texres axb t.png",
+  };
+
+  for (const auto line : lines) {
+    MtlParseStats stats;
+    CHECK(parse(string("newmtl a\n") + line + "\n", stats) == 1);
+  }
+}
+
+int
+main(void)
+{
+  testMaps();
+  testTruncated();
+  testBadValues();
+
+  return testFailures;
+}
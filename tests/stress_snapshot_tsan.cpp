@@ -0,0 +1,119 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+/* Built with -fsanitize=thread, see the Makefile 'test' target */
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MtlSnapshot.hpp"
+#include "MtlTest.hpp"
+
+#define NR_READERS 8
+#define NR_RELOADS 200
+#define SMALL_FILE "stress_snapshot.mtl"
+
+using namespace std;
+
+/**
+ Checks that 'snapshot' is entirely one of the two libraries the reloaders
+ alternate between, never empty or a mix of both
+ */
+static bool
+isConsistent(const MtlSnapshot& snapshot)
+{
+  static const char* large[] = { "plane", "glass", "seat", "pilot" };
+  static const char* small[] = { "red", "green" };
+  const char** names = nullptr;
+
+  if ((snapshot.materials.size() == 4) && (snapshot.fileName == "test.mtl"))
+    names = large;
+  else if ((snapshot.materials.size() == 2) &&
+      (snapshot.fileName == SMALL_FILE))
+    names = small;
+  else
+    return false;
+
+  if (snapshot.sortKeys.size() != snapshot.materials.size())
+    return false;
+
+  for (size_t i = 0; i < snapshot.materials.size(); ++i) {
+    const MtlMaterial& mat = snapshot.materials[i];
+    if ((mat.name != names[i]) || (mat.illumination != static_cast<int>(i + 1)))
+      return false;
+  }
+
+  for (const auto key : snapshot.sortKeys) {
+    if (mtlSortKeyIndex(key) >= snapshot.materials.size())
+      return false;
+  }
+
+  return true;
+}
+
+int
+main(void)
+{
+  {
+    ofstream small(SMALL_FILE);
+    small << "newmtl red\nKd 1 0 0\nillum 1\n" <<
+        "newmtl green\nKd 0 1 0\nillum 2\nmap_Kd green.png\n";
+  }
+
+  MtlLibrary lib("test.mtl");
+  atomic<bool> done(false);
+  atomic<long> reads(0), inconsistent(0), failedReloads(0);
+  vector<thread> readers;
+
+  for (int i = 0; i < NR_READERS; ++i) {
+    readers.emplace_back([&]() {
+      /* Keep one snapshot across iterations to exercise late frees */
+      shared_ptr<const MtlSnapshot> held = lib.snapshot();
+      while (!done) {
+        shared_ptr<const MtlSnapshot> current = lib.snapshot();
+        if (!isConsistent(*current) || !isConsistent(*held))
+          ++inconsistent;
+        if (reads++ % 64 == 0)
+          held = current;
+      }
+    });
+  }
+
+  /* A second publisher racing the reloader below */
+  thread publisher([&]() {
+    for (int i = 0; (i < NR_RELOADS) && !done; ++i)
+      lib.publish(lib.snapshot());
+  });
+
+  thread reloader([&]() {
+    for (int i = 0; i < NR_RELOADS; ++i) {
+      if (!lib.reload((i % 2) ? "test.mtl" : SMALL_FILE))
+        ++failedReloads;
+      /* Failed reloads must not publish anything */
+      if (lib.reload("missing.mtl"))
+        ++failedReloads;
+    }
+    done = true;
+  });
+
+  reloader.join();
+  publisher.join();
+  for (auto& reader : readers)
+    reader.join();
+
+  remove(SMALL_FILE);
+
+  CHECK(reads > 0);
+  CHECK(inconsistent == 0);
+  CHECK(failedReloads == 0);
+  fprintf(stderr, "%ld reads, %ld inconsistent\n", reads.load(),
+      inconsistent.load());
+
+  return testFailures;
+}
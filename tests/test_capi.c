@@ -0,0 +1,109 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+/* Built as C to check that MtlReader.h is usable from C */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MtlReader.h"
+
+static int testFailures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK(" #cond ") failed\n", __FILE__, \
+          __LINE__); \
+      ++testFailures; \
+    } \
+  } while (0)
+
+static void
+testFile(void)
+{
+  static const char* names[] = { "plane", "glass", "seat", "pilot" };
+  mtlHandle* handle = mtlOpenFile("test.mtl");
+  size_t size = 0;
+  const char* strings;
+  const uint32_t* nameOffsets;
+  const uint32_t* kdOffsets;
+  const uint32_t* dispOffsets;
+  const float* kd;
+  size_t i;
+
+  CHECK(handle != NULL);
+  if (!handle)
+    return;
+
+  strings = mtlStringTable(handle, &size);
+  nameOffsets = mtlNameOffsets(handle);
+  kdOffsets = mtlMapOffsets(handle, MS_KD);
+  dispOffsets = mtlMapOffsets(handle, MS_DISP);
+  kd = mtlColors(handle, CS_KD);
+
+  CHECK(mtlMaterialCount(handle) == 4);
+  CHECK(size > 0 && strings[0] == '\0');
+  for (i = 0; i < mtlMaterialCount(handle); ++i) {
+    CHECK(nameOffsets[i] < size && !strcmp(strings + nameOffsets[i],
+        names[i]));
+    CHECK(kdOffsets[i] != 0 && kdOffsets[i] < size);
+    CHECK(!strcmp(strings + kdOffsets[i], "test_map_Kd.png"));
+    CHECK(!strcmp(strings + dispOffsets[i], "test_disp.png"));
+    CHECK(kd[i * 3] == (float)((i + 1) * 10 + 1));
+    CHECK(mtlIllumination(handle)[i] == (int32_t)(i + 1));
+    CHECK(mtlDissolveHalo(handle)[i] == 1);
+    CHECK(mtlMapAntiAliasingTextures(handle)[i] == 0);
+  }
+  CHECK(mtlColors(handle, CS_COUNT) == NULL);
+  CHECK(mtlMapOffsets(handle, MS_COUNT) == NULL);
+
+  mtlClose(handle);
+}
+
+static void
+testBuffer(void)
+{
+  static const char data[] = "newmtl x\nKd 0.5 0.25 1\nmap_Ka a b.png\n";
+  mtlHandle* handle = mtlOpenBuffer(data, sizeof(data) - 1);
+  const char* strings;
+
+  CHECK(handle != NULL);
+  if (!handle)
+    return;
+
+  strings = mtlStringTable(handle, NULL);
+  CHECK(mtlMaterialCount(handle) == 1);
+  CHECK(mtlColors(handle, CS_KD)[1] == 0.25f);
+  CHECK(!strcmp(strings + mtlMapOffsets(handle, MS_KA)[0], "a b.png"));
+  CHECK(mtlMapOffsets(handle, MS_KD)[0] == 0);
+
+  mtlClose(handle);
+}
+
+static void
+testGarbage(void)
+{
+  static const char data[] = "\x01\x02 not an mtl file\nKd x\n";
+  mtlHandle* handle = mtlOpenBuffer(data, sizeof(data) - 1);
+
+  /* Not an error, just nothing to load */
+  CHECK(handle != NULL);
+  if (!handle)
+    return;
+
+  CHECK(mtlMaterialCount(handle) == 0);
+  mtlClose(handle);
+}
+
+int
+main(void)
+{
+  testFile();
+  testBuffer();
+  testGarbage();
+  CHECK(mtlOpenFile("missing.mtl") == NULL);
+
+  return testFailures;
+}
@@ -0,0 +1,96 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "MtlColorPass.hpp"
+#include "MtlObject.hpp"
+#include "MtlTest.hpp"
+
+/* Not a multiple of 4, so the scalar tail is used too */
+#define NR_COLORS 1027
+
+using namespace std;
+
+static bool
+matches(float value, float reference)
+{
+  return fabs(value - reference) <=
+      MTL_COLOR_PASS_TOLERANCE * max(1.0f, fabs(reference));
+}
+
+static float
+randomFloat(float low, float high)
+{
+  return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+/** Compares the SIMD pass against the scalar reference for 'flags' */
+static void
+testFlags(unsigned int flags)
+{
+  vector<float> red(NR_COLORS), green(NR_COLORS), blue(NR_COLORS);
+
+  for (size_t i = 0; i < NR_COLORS; ++i) {
+    /* Mix 0 - 1, 0 - 255 and out of range triples */
+    float high = (i % 3 == 0 ? 255.0f : (i % 3 == 1 ? 1.0f : 2.0f));
+    float low = (i % 5 == 0 ? -0.5f : 0.0f);
+    red[i] = randomFloat(low, high);
+    green[i] = randomFloat(low, high);
+    blue[i] = randomFloat(low, high);
+  }
+  /* Around the sRGB threshold */
+  red[1] = 0.04045f;
+  green[1] = 0.0404f;
+  blue[1] = 0.0405f;
+
+  vector<float> refRed(red), refGreen(green), refBlue(blue);
+  mtlColorPass(red.data(), green.data(), blue.data(), NR_COLORS, flags);
+  mtlColorPassScalar(refRed.data(), refGreen.data(), refBlue.data(),
+      NR_COLORS, flags);
+
+  int mismatches = 0;
+  for (size_t i = 0; i < NR_COLORS; ++i) {
+    if (!matches(red[i], refRed[i]) || !matches(green[i], refGreen[i]) ||
+        !matches(blue[i], refBlue[i])) {
+      ++mismatches;
+      if (mismatches == 1)
+        cerr << "flags " << flags << " index " << i << ": " << red[i] <<
+            " " << green[i] << " " << blue[i] << " != " << refRed[i] << " " <<
+            refGreen[i] << " " << refBlue[i] << endl;
+    }
+    if (flags & CP_CLAMP) {
+      CHECK(red[i] >= 0.0f && red[i] <= 1.0f);
+      CHECK(green[i] >= 0.0f && green[i] <= 1.0f);
+      CHECK(blue[i] >= 0.0f && blue[i] <= 1.0f);
+    }
+  }
+  CHECK(mismatches == 0);
+}
+
+static void
+testTestMtl(void)
+{
+  MtlObject mtl("test.mtl");
+  mtl.normalizeColors(CP_NORMALIZE_255 | CP_CLAMP);
+
+  /* Kd 11 12 13 is 0 - 255 encoded, Ka is already 0 - 1 */
+  CHECK(matches(mtl.materials[0]->diffuseColor.red, 11.0f / 255.0f));
+  CHECK(matches(mtl.materials[0]->diffuseColor.blue, 13.0f / 255.0f));
+  CHECK(matches(mtl.materials[0]->ambientColor.red, 0.117647f));
+  CHECK(matches(mtl.materials[2]->transformFilter.green, 0.5f));
+}
+
+int
+main(void)
+{
+  for (unsigned int flags = 0; flags <= CP_ALL; ++flags)
+    testFlags(flags);
+  testTestMtl();
+
+  return testFailures;
+}
@@ -0,0 +1,53 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <sstream>
+#include <string>
+
+#include "MtlObject.hpp"
+#include "MtlParseStats.hpp"
+#include "MtlTest.hpp"
+
+using namespace std;
+
+static size_t
+keyIndex(const string& name)
+{
+  size_t i = 0;
+  while (MtlParseStats::keyName(i) && (name != MtlParseStats::keyName(i)))
+    ++i;
+  return i;
+}
+
+int
+main(void)
+{
+  MtlParseStats stats;
+  MtlObject mtl("test.mtl", &stats);
+
+  CHECK(stats.bytesRead == 2841);
+  CHECK(stats.linesRead == 88);
+  CHECK(stats.materialLines == 4);
+  CHECK(stats.keyLines[keyIndex("Tf")] == 1);
+  CHECK(stats.keyLines[keyIndex("map_Kd")] == 4);
+  CHECK(stats.skippedLines == 7);
+  CHECK(stats.valueFailures == 0);
+
+  /* Counters add up over several parses, no stats means none are kept */
+  istringstream data("newmtl a\nKd x y z\nNs 5\n");
+  MtlObject buffer(data, "buffer", &stats);
+  CHECK(stats.materialLines == 5);
+  CHECK(stats.valueFailures == 1);
+  CHECK(stats.linesRead == 91);
+
+  MtlObject noStats("test.mtl");
+  CHECK(stats.linesRead == 91);
+
+  ostringstream json;
+  stats.printJson(json);
+  CHECK(json.str().find("\"linesRead\": 91") != string::npos);
+  CHECK(json.str().find("\"map_Kd\": 4") != string::npos);
+
+  return testFailures;
+}
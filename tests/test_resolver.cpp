@@ -0,0 +1,104 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "ObjMtlResolver.hpp"
+#include "MtlTest.hpp"
+
+#define TEST_OBJ "test_resolver.obj"
+#define TEST_CRLF_OBJ "test_resolver_crlf.obj"
+#define TEST_CRLF_MTL "test_resolver_crlf.mtl"
+
+using namespace std;
+
+static bool
+isRange(const ObjMtlRange& range, const string& name,
+    const ObjMtlResolver& resolver, size_t firstFace, size_t faceCount)
+{
+  if ((range.firstFace != firstFace) || (range.faceCount != faceCount))
+    return false;
+  if (name.empty())
+    return range.materialIndex == -1;
+  return (range.materialIndex >= 0) &&
+      (resolver.materials[range.materialIndex]->name == name);
+}
+
+/** An MTL file written by a Windows exporter */
+static void
+testCrlfMtl(void)
+{
+  {
+    ofstream mtl(TEST_CRLF_MTL, ios::binary);
+    mtl << "# CRLF\r\nnewmtl red\r\nKd 1 0 0\r\nnewmtl green \r\n";
+    ofstream obj(TEST_CRLF_OBJ, ios::binary);
+    obj << "mtllib " TEST_CRLF_MTL "\n"
+        "usemtl red\n"
+        "f 1 2 3\n"
+        "usemtl green\r\n"
+        "f 1 2 3\r\n";
+  }
+
+  ObjMtlResolver resolver(TEST_CRLF_OBJ);
+  remove(TEST_CRLF_OBJ);
+  remove(TEST_CRLF_MTL);
+
+  CHECK(resolver.materials.size() == 2);
+  CHECK(resolver.ranges.size() == 2);
+  if (resolver.ranges.size() == 2) {
+    CHECK(isRange(resolver.ranges[0], "red", resolver, 0, 1));
+    CHECK(isRange(resolver.ranges[1], "green", resolver, 1, 1));
+  }
+}
+
+int
+main(void)
+{
+  testCrlfMtl();
+
+  {
+    ofstream obj(TEST_OBJ);
+    obj << "# faces before any usemtl\n"
+        "mtllib test.mtl\n"
+        "v 0 0 0\n"
+        "vt 0 0\n"
+        "f 1 1 1\n"
+        "usemtl glass\r\n" /* CRLF */
+        "f 1 2 3\n"
+        "  usemtl glass\n" /* indented, same material: merged */
+        "f 1 2 3\n"
+        "usemtl seat\n" /* no faces: reused by the next usemtl */
+        "usemtl glass\n"
+        "\tf 1 2 3\n"
+        "usemtl unknown\n"
+        "f 1 1 1\n"
+        "fo 1 2 3\n" /* not a face */
+        "mtllib test.mtl\n" /* already loaded */
+        "usemtl pilot\n"
+        "f 1 2 3\r\n"
+        "f 1 2 3\n"
+        "usemtl plane\n"; /* trailing, no faces */
+  }
+
+  ObjMtlResolver resolver(TEST_OBJ);
+  remove(TEST_OBJ);
+
+  CHECK(resolver.libraries.size() == 1);
+  CHECK(resolver.materials.size() == 4);
+  CHECK(resolver.ranges.size() == 4);
+  if (resolver.ranges.size() == 4) {
+    CHECK(isRange(resolver.ranges[0], "", resolver, 0, 1));
+    CHECK(isRange(resolver.ranges[1], "glass", resolver, 1, 3));
+    CHECK(isRange(resolver.ranges[2], "", resolver, 4, 1));
+    CHECK(isRange(resolver.ranges[3], "pilot", resolver, 5, 2));
+  }
+
+  ObjMtlResolver missing("missing.obj");
+  CHECK(missing.ranges.empty());
+  CHECK(missing.materials.empty());
+
+  return testFailures;
+}
@@ -0,0 +1,51 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <memory>
+
+#include "MtlSnapshot.hpp"
+#include "MtlTest.hpp"
+
+using namespace std;
+
+static void
+testReload(void)
+{
+  MtlLibrary lib("test.mtl");
+  shared_ptr<const MtlSnapshot> first = lib.snapshot();
+
+  CHECK(first->materials.size() == 4);
+  CHECK(first->sortKeys.size() == 4);
+  CHECK(first->queryMaterials(MF_ILLUM_MASK, mtlIllumFeature(3)).size() ==
+      1);
+
+  /* A failed reload keeps the current snapshot */
+  CHECK(!lib.reload("missing.mtl"));
+  CHECK(lib.snapshot() == first);
+
+  /* A successful one replaces it, the old one stays valid for its holder */
+  CHECK(lib.reload("test.mtl"));
+  CHECK(lib.snapshot() != first);
+  CHECK(lib.snapshot()->materials.size() == 4);
+  CHECK(first->materials[1].name == "glass");
+}
+
+static void
+testEmpty(void)
+{
+  MtlLibrary empty;
+  CHECK(empty.snapshot() && empty.snapshot()->materials.empty());
+
+  MtlLibrary missing("missing.mtl");
+  CHECK(missing.snapshot() && missing.snapshot()->materials.empty());
+}
+
+int
+main(void)
+{
+  testReload();
+  testEmpty();
+
+  return testFailures;
+}
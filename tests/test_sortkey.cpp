@@ -0,0 +1,77 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "MtlObject.hpp"
+#include "MtlSortKey.hpp"
+#include "MtlTest.hpp"
+
+using namespace std;
+
+static void
+testTestMtl(void)
+{
+  MtlObject mtl("test.mtl");
+  const uint32_t maps = MF_MAP_KA | MF_MAP_KD | MF_MAP_KS | MF_MAP_NS |
+      MF_DECAL | MF_DISP;
+
+  CHECK(mtl.materials.size() == 4);
+  CHECK(mtl.sortKeys().size() == 4);
+  for (const auto key : mtl.sortKeys()) {
+    uint32_t index = mtlSortKeyIndex(key);
+    uint32_t features = mtlSortKeyFeatures(key);
+    CHECK(features == (MF_TRANSPARENT | mtlIllumFeature(index + 1) | maps));
+  }
+
+  CHECK(mtl.materials[1]->mapDiffuseColor.fileName == "test_map_Kd.png");
+  CHECK(mtl.materials[1]->mapDiffuseColor.scale[0] == 2.0f);
+  CHECK(mtl.materials[1]->mapDiffuseColor.scale[1] == 2.0f);
+  CHECK(mtl.materials[1]->mapDiffuseColor.mm[1] == 1.0f);
+  CHECK(mtl.materials[3]->decal.fileName == "test_decal.png");
+  CHECK(mtl.materials[3]->decal.scale[0] == 7.0f);
+
+  vector<uint32_t> glass = mtl.queryMaterials(MF_ILLUM_MASK | MF_MAP_KD,
+      mtlIllumFeature(2) | MF_MAP_KD);
+  CHECK(glass.size() == 1);
+  CHECK(!glass.empty() && mtl.materials[glass[0]]->name == "glass");
+
+  CHECK(mtl.queryMaterials(MF_TRANSPARENT, MF_TRANSPARENT).size() == 4);
+  CHECK(mtl.queryMaterials(MF_MAP_AAT, MF_MAP_AAT).empty());
+  CHECK(mtl.queryMaterials([](uint32_t features) {
+    return (features & MF_ILLUM_MASK) >= mtlIllumFeature(3);
+  }) == vector<uint32_t>({ 2, 3 }));
+}
+
+static void
+testRadixSort(void)
+{
+  vector<uint64_t> keys;
+  for (int i = 0; i < 10000; ++i)
+    keys.push_back((static_cast<uint64_t>(rand()) << 32) | rand());
+  /* Also a byte where all keys are equal */
+  for (auto& key : keys)
+    key &= ~(0xffull << 40);
+
+  vector<uint64_t> expected(keys);
+  sort(expected.begin(), expected.end());
+  mtlRadixSort(keys);
+  CHECK(keys == expected);
+
+  vector<uint64_t> empty;
+  mtlRadixSort(empty);
+  CHECK(empty.empty());
+}
+
+int
+main(void)
+{
+  testTestMtl();
+  testRadixSort();
+
+  return testFailures;
+}
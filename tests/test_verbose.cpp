@@ -0,0 +1,54 @@
+/**
+ * @copyright 2017 Andreas Bank, andreas.mikael.bank@gmail.com
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "MtlObject.hpp"
+#include "MtlSnapshot.hpp"
+#include "MtlTest.hpp"
+
+using namespace std;
+
+/* Materials, a line before the first newmtl and a value that fails */
+static const char* data = "Kd 1 0 0\nnewmtl red\nKd x\nnewmtl green\n";
+
+/** Returns everything written to stdout and stderr while loading 'data' */
+static string
+captureLoad(void)
+{
+  ostringstream captured;
+  streambuf* out = cout.rdbuf(captured.rdbuf());
+  streambuf* err = cerr.rdbuf(captured.rdbuf());
+
+  istringstream dataStream(data);
+  MtlObject object(dataStream);
+  MtlObject missing("missing.mtl");
+  MtlLibrary lib;
+  lib.reload("missing.mtl");
+
+  cout.rdbuf(out);
+  cerr.rdbuf(err);
+  CHECK(object.materials.size() == 2);
+
+  return captured.str();
+}
+
+int
+main(void)
+{
+  CHECK(!MtlObject::verbose());
+  CHECK(captureLoad().empty());
+
+  MtlObject::setVerbose(true);
+  string output = captureLoad();
+  MtlObject::setVerbose(false);
+  CHECK(output.find("Created material 'red'") != string::npos);
+  CHECK(output.find("No material yet") != string::npos);
+  CHECK(output.find("Failed parsing 'Kd'") != string::npos);
+  CHECK(output.find("Failed to open file 'missing.mtl'") != string::npos);
+
+  return testFailures;
+}